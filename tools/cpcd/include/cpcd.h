@@ -17,11 +17,19 @@
 #ifndef _CPCD_H_
 #define _CPCD_H_
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <limits>
 #include <list>
 #include <map>
+#include <vector>
 
 #include "yaml-cpp/yaml.h"
 
@@ -37,19 +45,75 @@ namespace CPCD {
   typedef YAML::Exception      Exception;
   typedef YAML::const_iterator Iterator;
 
-  static Node
+  inline Node
   YAMLLoad (const std::string& string)
   {
     return YAML::Load(string);
   }
 
-  static Node
+  inline Node
   YAMLLoadFile (const std::string& string)
   {
     return YAML::LoadFile(string);
   }
 
-  
+  inline std::string
+  YAMLDump (const Node& node)
+  {
+    return YAML::Dump(node);
+  }
+
+
+  // arena-backed string interning table: each distinct string
+  // is stored once and referenced by a compact identifier
+  class StringPool {
+
+    public:
+
+      typedef unsigned int Symbol;
+      static const Symbol npos = static_cast<Symbol>(-1);
+
+      // constructor
+      StringPool ();
+
+      // destructor
+      ~StringPool ();
+
+      // store string, if not yet stored, and return its identifier
+      Symbol intern (const std::string& string);
+      // return identifier of stored string, or npos if not stored
+      Symbol find (const std::string& string) const;
+      // return stored string and its length
+      const char* str (Symbol id) const;
+      std::size_t length (Symbol id) const;
+      // compare stored strings
+      int compare (Symbol lhs, Symbol rhs) const;
+
+    private:
+
+      // copying is not allowed
+      StringPool (const StringPool&);
+      StringPool& operator= (const StringPool&);
+
+      // copy string to arena
+      const char* Store (const std::string& string);
+      // return hash table slot for string
+      std::size_t Lookup (const std::string& string, unsigned long long hash) const;
+      // double hash table size
+      void Rehash ();
+
+      // private data members
+      std::vector<char*>              blocks;   // arena memory blocks
+      std::size_t                     used;     // bytes used in last block
+      std::size_t                     capacity; // size of last block
+      std::vector<const char*>        strings;  // stored strings, by identifier
+      std::vector<std::size_t>        lengths;  // stored string lengths, by identifier
+      std::vector<unsigned long long> hashes;   // stored string hashes, by identifier
+      std::vector<Symbol>             table;    // open-addressing hash table
+
+  }; // class StringPool
+
+
   // class declaration
   class CPCD;
 
@@ -65,6 +129,7 @@ namespace CPCD {
 
       // public basic I/O methods
       int read (const std::string& filename);
+      int load (const std::string& string);
 
       int write () const ;
       int write (const std::string& filename) const;
@@ -84,13 +149,29 @@ namespace CPCD {
       // validate syntax of the physical constant dictionary
       int validate ();
 
+      // verify that requested constants are exact in requested precisions
+      int verify () const;
+
       // emit requested physical constants as Fortran module
       int femit (const std::string& filename) const;
+      int femit (std::ostream& ostream) const;
+
+      // emit provenance metadata of requested physical constants as JSON
+      int memit (const std::string& filename) const;
+      int memit (std::ostream& ostream) const;
+
+      // emit make/ninja dependency file for stamp target, and update stamp
+      int demit (const std::string& filename, const std::string& stamp) const;
+
+      // compare dictionary with reference dictionary -- restricted
+      // to user-requested constants if a user request is set
+      int diff (const CPCD& ref, Node& changes) const;
 
 
       // public data members
       int verbose;
       int depth;
+      int lazy;     // load dictionary sets on demand
 
     private:
 
@@ -100,21 +181,81 @@ namespace CPCD {
       // parse user request
       int ParseReq (const Node& req, Node& preq);
 
+      // check that alias expansion is bounded by input size
+      int CheckNode (const Node& node, std::size_t size) const;
+
       // validate
       int ValidateNode (const Node& node, const Node& syntax);
 
+      // interned user request and resolved physical constants
+      typedef StringPool::Symbol Symbol;
+      typedef std::vector<Symbol> SymbolList;
+      typedef std::map<Symbol, SymbolList> SymbolMap;
+      struct Constant {
+        Symbol set;          // set name
+        Symbol name;         // constant name
+        Symbol value;        // constant value
+        Symbol units;        // metadata -- npos if not available
+        Symbol prec;
+        Symbol type;
+        Symbol uncertainty;
+        Symbol relative_uncertainty;
+        Symbol description;
+        Symbol citation;     // set citation
+      };
+      typedef std::vector<Constant> ConstantList;
+
       // parse
-      int ParseNode (const Node& node, const Node& req, Node& map);
+      int ParseNode (const Node& node, const SymbolMap& req, ConstantList& table);
+      int ParseEntries (const Node& node, Symbol set, const SymbolList& names, ConstantList& table);
+      Symbol InternField (const Node& node, const std::string& key);
 
       // emit
-      int emitF (std::ostream& os, const Node& map) const;
+      int emitF (std::ostream& os, const ConstantList& table) const;
+      int emitY (std::ostream& os, const ConstantList& table) const;
+      int emitJ (std::ostream& os, const ConstantList& table) const;
+
+      // hashed records of dictionary sets and entries
+      typedef unsigned long long Hash;
+      typedef std::map<std::string, Hash> HashMap;
+      struct Record {
+        Hash    hash;     // hash of whole set
+        HashMap entries;  // hash of each set entry, by name
+      };
+      typedef std::map<std::string, Record> RecordMap;
+
+      // compute hashed records
+      int HashNode (const Node& node, RecordMap& records) const;
+
+      // byte offsets of dictionary sets in raw dictionary text
+      struct Offset {
+        std::string name;   // set name
+        std::size_t begin;  // offset of first byte
+        std::size_t end;    // offset past last byte
+        Node        node;   // set content, once loaded
+      };
+      typedef std::vector<Offset> OffsetList;
+
+      // lazy loading
+      int ScanSets (const std::string& text, std::size_t& header, OffsetList& index) const;
+      int LoadSets (const Node& req);
+      int Materialize () const;
       
       // private data members
-      Node doc;    // stores YAML physical constant dictionary
+      mutable Node doc;          // stores YAML physical constant dictionary
+      mutable OffsetList index;  // stores offsets of physical constant sets (lazy mode)
+      std::string text;          // stores raw physical constant dictionary (lazy mode)
+      Hash checksum;             // stores hash of raw physical constant dictionary
+      std::string dictfile;      // stores physical constant dictionary file name
+      std::string reqfile;       // stores user request file name
       Node req;    // stores original YAML user request for physical constants
       Node sel;    // stores physical constant list parsed from input user request
+      int  reqset; // stores whether a user request was loaded, even if empty
       Node syntax; // stores syntax reference for physical constant dictionary for validation purposes
-      Node map;    // work map
+
+      StringPool   pool;   // stores set and constant names and values
+      SymbolMap    rsel;   // stores interned physical constant list parsed from input user request
+      ConstantList table;  // stores resolved user-requested physical constants
 
   }; // class CPCD
 
@@ -29,10 +29,387 @@ namespace CPCD {
      return CPCD_FAILURE;
    }
 
+  static unsigned long long
+  HashString (const std::string& string)
+  {
+    // compute 64-bit FNV-1a hash of input string
+    // -- private class method
+    unsigned long long hash = 14695981039346656037ULL;
+    for (std::string::const_iterator it=string.begin(); it!=string.end(); it++) {
+      hash ^= static_cast<unsigned char>(*it);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  static void
+  WriteJSON (std::ostream& os, const char* str)
+  {
+    // write string as quoted JSON string
+    // -- private class method
+    static const char hex[] = "0123456789abcdef";
+    os << '"';
+    for (const char* c=str; *c; c++) {
+      switch (*c) {
+        case '"':  os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n";  break;
+        case '\t': os << "\\t";  break;
+        default:
+          if (static_cast<unsigned char>(*c) < 0x20)
+            os << "\\u00" << hex[(*c >> 4) & 0xf] << hex[*c & 0xf];
+          else
+            os << *c;
+      }
+    }
+    os << '"';
+  }
+
+  static int
+  WriteFile (const std::string& filename, const std::string& content)
+  {
+    // write content to file only if file content differs,
+    // so that file timestamp changes only with its content
+    // -- private class method
+    std::ifstream is(filename, std::ios::binary);
+    if (is) {
+      std::ostringstream buf;
+      buf << is.rdbuf();
+      if (buf.str() == content)
+        return CPCD_SUCCESS;
+      is.close();
+    }
+    std::ofstream of(filename, std::ios::binary);
+    of << content;
+    of.close();
+    if (!of)
+      return SetError("unable to write file: " + filename);
+    return CPCD_SUCCESS;
+  }
+
+  static std::string
+  MakeEscape (const std::string& path)
+  {
+    // escape file path for use in make dependency rules
+    // -- private class method
+    std::string str;
+    for (std::string::const_iterator it=path.begin(); it!=path.end(); it++) {
+      if (*it == ' ' || *it == '#')
+        str += '\\';
+      else if (*it == '$')
+        str += '$';
+      str += *it;
+    }
+    return str;
+  }
+
+  static bool
+  PlainName (const std::string& name)
+  {
+    // return true if name is a plain YAML scalar made of letters,
+    // digits, and _ . - only, so that it is read verbatim as set
+    // name (no flow collection, anchor, tag, or trailing blank)
+    // -- private class method
+    if (name.empty() || name[0] == '-' || name[0] == '.')
+      return false;
+    for (std::string::const_iterator it=name.begin(); it!=name.end(); it++) {
+      if (!((*it >= 'a' && *it <= 'z') || (*it >= 'A' && *it <= 'Z') ||
+            (*it >= '0' && *it <= '9') || *it == '_' || *it == '.' || *it == '-'))
+        return false;
+    }
+    return true;
+  }
+
+  static void
+  ScanScalars (const std::string& line, char& quote, int& flow)
+  {
+    // update state of quoted scalars and flow collections left open
+    // at end of line: quote is the open quote character, or 0, and
+    // flow is the nesting depth of open flow collections
+    // -- private class method
+    for (std::size_t i=0; i<line.size(); i++) {
+      char c = line[i];
+      if (quote == '"') {
+        if (c == '\\')
+          i++;
+        else if (c == '"')
+          quote = 0;
+      } else if (quote == '\'') {
+        if (c == '\'' && i + 1 < line.size() && line[i+1] == '\'')
+          i++;
+        else if (c == '\'')
+          quote = 0;
+      } else {
+        bool token = (i == 0) || std::string(" \t,:[{").find(line[i-1]) != std::string::npos;
+        if (c == '#' && (i == 0 || line[i-1] == ' ' || line[i-1] == '\t'))
+          break;
+        if (token && (c == '"' || c == '\''))
+          quote = c;
+        else if ((token || flow > 0) && (c == '[' || c == '{'))
+          flow++;
+        else if (flow > 0 && (c == ']' || c == '}'))
+          flow--;
+      }
+    }
+  }
+
+
+  // decimal literal normalized as sign, significant digits
+  // d1 d2 ... dn, and exponent e, with value +/-d1.d2...dn x 10^e
+  struct Decimal {
+    bool        valid;
+    bool        negative;
+    std::string digits;
+    long        exponent;
+  };
+
+  static Decimal
+  ParseDecimal (const char* str)
+  {
+    // normalize decimal literal, also accepting
+    // Fortran double precision exponents (D)
+    // -- private class method
+    Decimal dec;
+    dec.valid    = false;
+    dec.negative = false;
+    dec.exponent = 0;
+    const char* c = str;
+    if (*c == '+' || *c == '-')
+      dec.negative = (*c++ == '-');
+    long point = -1, ndigits = 0, lead = 0;
+    bool any = false;
+    for (; (*c >= '0' && *c <= '9') || *c == '.'; c++) {
+      if (*c == '.') {
+        if (point >= 0)
+          return dec;
+        point = ndigits;
+        continue;
+      }
+      any = true;
+      if (dec.digits.empty() && *c == '0') {
+        lead++;
+      } else {
+        dec.digits += *c;
+      }
+      ndigits++;
+    }
+    if (!any)
+      return dec;
+    if (point < 0)
+      point = ndigits;
+    if (*c == 'e' || *c == 'E' || *c == 'd' || *c == 'D') {
+      // clamp exponent well beyond any floating-point range,
+      // so that adjusting it below cannot overflow
+      const long maxexp = 1000000000L;
+      char* end;
+      long exp = std::strtol(++c, &end, 10);
+      if (end == c)
+        return dec;
+      dec.exponent = std::max(-maxexp, std::min(maxexp, exp));
+      c = end;
+    }
+    if (*c != '\0')
+      return dec;
+    dec.valid = true;
+    dec.digits.erase(dec.digits.find_last_not_of('0') + 1);
+    if (dec.digits.empty())
+      dec.exponent = 0;
+    else
+      dec.exponent += point - lead - 1;
+    return dec;
+  }
+
+  template <typename T> static T ToBinary (const char* str, char** end);
+  template <> float       ToBinary (const char* str, char** end) { return std::strtof(str, end); }
+  template <> double      ToBinary (const char* str, char** end) { return std::strtod(str, end); }
+  template <> long double ToBinary (const char* str, char** end) { return std::strtold(str, end); }
+
+  template <typename T>
+  static std::string
+  ToDecimal (T value, int digits)
+  {
+    // format binary value in scientific notation
+    // with given number of significant digits
+    // -- private class method
+    std::vector<char> buf(digits + 32);
+    std::snprintf(buf.data(), buf.size(), "%.*Le", digits - 1, static_cast<long double>(value));
+    return std::string(buf.data());
+  }
+
+  template <typename T>
+  static void
+  RoundTrip (const std::vector<Decimal>& dec, const std::vector<std::string>& lit,
+             const std::vector<bool>& mask, std::vector<int>& status)
+  {
+    // convert all masked literals to binary values of type T in bulk,
+    // then check that each value formats back to the same significant
+    // digits. Status is set to 1 for inexact values, including values
+    // underflowing to subnormal numbers or zero, and to 2 for values
+    // overflowing the range of T
+    // -- private class method
+    std::vector<T> bin(lit.size());
+    std::vector<int> range(lit.size(), 0);
+    for (std::size_t i=0; i<lit.size(); i++) {
+      if (!mask[i])
+        continue;
+      errno = 0;
+      bin[i] = ToBinary<T>(lit[i].c_str(), NULL);
+      if (errno == ERANGE)
+        range[i] = std::isinf(bin[i]) ? 2 : 1;
+    }
+    for (std::size_t i=0; i<lit.size(); i++) {
+      if (!mask[i])
+        continue;
+      if (range[i]) {
+        status[i] = std::max(status[i], range[i]);
+        continue;
+      }
+      // values with at most digits10 significant digits always round-trip
+      int n = dec[i].digits.size();
+      if (n <= std::numeric_limits<T>::digits10)
+        continue;
+      Decimal back = ParseDecimal(ToDecimal<T>(bin[i], n).c_str());
+      if (back.digits != dec[i].digits || back.exponent != dec[i].exponent)
+        status[i] = std::max(status[i], 1);
+    }
+  }
+
+
+  // StringPool class member function definition
+
+  const StringPool::Symbol StringPool::npos;
+
+  // - constructor
+  StringPool::StringPool() : used(0), capacity(0), table(64, static_cast<Symbol>(-1)) {};
+
+  // - destructor
+  StringPool::~StringPool()
+  {
+    for (std::vector<char*>::iterator it=this->blocks.begin(); it!=this->blocks.end(); it++)
+      delete [] *it;
+  };
+
+  StringPool::Symbol
+  StringPool::intern (const std::string& string)
+  {
+    // store string in arena, if not yet stored,
+    // and return its identifier
+    // -- public class method
+    unsigned long long hash = HashString(string);
+    std::size_t slot = this->Lookup(string, hash);
+    if (this->table[slot] != npos)
+      return this->table[slot];
+
+    Symbol id = this->strings.size();
+    this->strings.push_back(this->Store(string));
+    this->lengths.push_back(string.size());
+    this->hashes.push_back(hash);
+    this->table[slot] = id;
+
+    // keep hash table at most half full
+    if (2 * this->strings.size() > this->table.size())
+      this->Rehash();
+
+    return id;
+  }
+
+  StringPool::Symbol
+  StringPool::find (const std::string& string) const
+  {
+    // return identifier of stored string,
+    // or npos if string is not stored
+    // -- public class method
+    return this->table[this->Lookup(string, HashString(string))];
+  }
+
+  const char*
+  StringPool::str (Symbol id) const
+  {
+    // return null-terminated stored string
+    // -- public class method
+    return this->strings[id];
+  }
+
+  std::size_t
+  StringPool::length (Symbol id) const
+  {
+    // return length of stored string
+    // -- public class method
+    return this->lengths[id];
+  }
+
+  int
+  StringPool::compare (Symbol lhs, Symbol rhs) const
+  {
+    // compare stored strings lexicographically
+    // -- public class method
+    if (lhs == rhs)
+      return 0;
+    std::size_t n = std::min(this->lengths[lhs], this->lengths[rhs]);
+    int rc = std::char_traits<char>::compare(this->strings[lhs], this->strings[rhs], n);
+    if (rc)
+      return rc;
+    return (this->lengths[lhs] < this->lengths[rhs]) ? -1 : 1;
+  }
+
+  const char*
+  StringPool::Store (const std::string& string)
+  {
+    // copy string to arena, allocating a new
+    // memory block if needed
+    // -- private class method
+    const std::size_t blocksize = 65536;
+    std::size_t size = string.size() + 1;
+    if (this->blocks.empty() || this->used + size > this->capacity) {
+      this->capacity = std::max(blocksize, size);
+      this->blocks.push_back(new char[this->capacity]);
+      this->used = 0;
+    }
+    char* ptr = this->blocks.back() + this->used;
+    string.copy(ptr, string.size());
+    ptr[string.size()] = '\0';
+    this->used += size;
+    return ptr;
+  }
+
+  std::size_t
+  StringPool::Lookup (const std::string& string, unsigned long long hash) const
+  {
+    // return hash table slot holding string,
+    // or empty slot where string should be stored
+    // -- private class method
+    std::size_t mask = this->table.size() - 1;
+    for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+      Symbol id = this->table[slot];
+      if (id == npos)
+        return slot;
+      if (this->hashes[id] == hash && this->lengths[id] == string.size() &&
+          !string.compare(0, string.size(), this->strings[id], this->lengths[id]))
+        return slot;
+    }
+  }
+
+  void
+  StringPool::Rehash ()
+  {
+    // double hash table size and reinsert stored strings
+    // -- private class method
+    std::vector<Symbol> t(2 * this->table.size(), static_cast<Symbol>(-1));
+    std::size_t mask = t.size() - 1;
+    for (Symbol id=0; id<this->strings.size(); id++) {
+      std::size_t slot = this->hashes[id] & mask;
+      while (t[slot] != npos)
+        slot = (slot + 1) & mask;
+      t[slot] = id;
+    }
+    this->table.swap(t);
+  }
+
+
   // CPCD class member function definition
 
   // - constructor
-  CPCD::CPCD() : syntax(YAMLLoad(dict_syntax)) {};
+  CPCD::CPCD() : verbose(0), depth(0), lazy(0), checksum(0), reqset(0), syntax(YAMLLoad(dict_syntax)) {};
 
   // - standard destructor
   CPCD::~CPCD() {};
@@ -45,11 +422,50 @@ namespace CPCD {
   int
   CPCD::read (const std::string& filename)
   {
-    // read physical constant dictionary and store
-    // its content to private class member
+    // read physical constant dictionary from file
+    // and store its content to private class member
+    // -- public class method
+    std::ifstream is(filename);
+    if (!is)
+      return SetError("unable to open file: " + filename);
+    std::ostringstream buf;
+    buf << is.rdbuf();
+    int rc = this->load(buf.str());
+    if (rc == CPCD_SUCCESS)
+      this->dictfile = filename;
+    return rc;
+  }
+
+  int
+  CPCD::load (const std::string& string)
+  {
+    // load physical constant dictionary from YAML string
+    // and store its content to private class member. In lazy
+    // mode, only record offsets of dictionary sets, which are
+    // then loaded on demand
     // -- public class method
     try {
-      this->doc = YAMLLoadFile(filename);
+      this->index.clear();
+      this->text.clear();
+      this->dictfile.clear();
+      this->checksum = HashString(string);
+      if (this->lazy) {
+        std::size_t header;
+        if (this->ScanSets(string, header, this->index) == CPCD_SUCCESS) {
+          this->text = string;
+          this->doc  = YAMLLoad(this->text.substr(0, header));
+          const Node& d = this->doc;
+          if (d.IsMap() && d["physical_constants_dictionary"] &&
+              d["physical_constants_dictionary"]["set"] &&
+              d["physical_constants_dictionary"]["set"].IsNull())
+            return this->CheckNode(this->doc, header);
+        }
+        // dictionary layout does not allow lazy loading
+        this->index.clear();
+        this->text.clear();
+      }
+      this->doc = YAMLLoad(string);
+      return this->CheckNode(this->doc, string.size());
     } catch (const Exception& e) {
       return SetError(e.what());
     }
@@ -63,6 +479,8 @@ namespace CPCD {
     // dictionary to standard output
     // -- public class method
     try {
+      if (this->Materialize())
+        return SetError("failure loading dictionary");
       std::cout << this->doc << std::endl;
     } catch (const Exception& e) {
       return SetError(e.what());
@@ -77,6 +495,8 @@ namespace CPCD {
     // dictionary to file
     // -- public class method
     try {
+      if (this->Materialize())
+        return SetError("failure loading dictionary");
       std::ofstream of(filename);
       of << this->doc << std::endl;
       of.close();
@@ -93,6 +513,8 @@ namespace CPCD {
     // dictionary to input output stream object
     // -- public class method
     try {
+      if (this->Materialize())
+        return SetError("failure loading dictionary");
       os << this->doc << std::endl;
     } catch (const Exception& e) {
       return SetError(e.what());
@@ -110,16 +532,15 @@ namespace CPCD {
     // from YAML file, then rearrange (parse)
     // request in a more convenient YAML format
     // -- public class method
-    try {
-      this->req = YAMLLoadFile(filename);
-      std::cout << this->req << std::endl;
-      if (this->ParseReq(this->req, this->sel)) {
-        return SetError("failure parsing dictionary request");
-      }
-    } catch (const Exception& e) {
-      return SetError(e.what());
-    }
-    return CPCD_SUCCESS;
+    std::ifstream is(filename);
+    if (!is)
+      return SetError("unable to open file: " + filename);
+    std::ostringstream buf;
+    buf << is.rdbuf();
+    int rc = this->loadreq(buf.str());
+    if (rc == CPCD_SUCCESS)
+      this->reqfile = filename;
+    return rc;
   }
     
   int
@@ -130,9 +551,14 @@ namespace CPCD {
     // request in a more convenient YAML format
     // -- public class method
     try {
+      this->reqfile.clear();
+      this->reqset = 0;
       this->req = YAMLLoad(request);
+      if (this->CheckNode(this->req, request.size()))
+        return SetError("failure loading dictionary request");
       if (this->ParseReq(this->req, this->sel))
         return SetError("failure parsing dictionary request");
+      this->reqset = 1;
     } catch (const Exception& e) {
       return SetError(e.what());
     }
@@ -169,43 +595,216 @@ namespace CPCD {
   }
 
 
+  // - lazy loading
+
+  int
+  CPCD::ScanSets (const std::string& text, std::size_t& header, OffsetList& index) const
+  {
+    // scan raw physical constant dictionary once and record byte
+    // offsets of each set, so that sets can be loaded on demand.
+    // Only block-style set lists with plain set names can be scanned:
+    // failure is returned without error message for any other layout,
+    // or if a quoted scalar or flow collection spans a set boundary
+    // -- private class method
+    const std::size_t npos = std::string::npos;
+    std::size_t skey   = npos;  // indentation of set key
+    std::size_t indent = npos;  // indentation of set list items
+    char        quote  = 0;     // open quote character
+    int         flow   = 0;     // depth of open flow collections
+
+    header = npos;
+    index.clear();
+
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      std::size_t start = pos;
+      pos = text.find('\n', start);
+      pos = (pos == npos) ? text.size() : pos + 1;
+
+      // retrieve line content without indentation and trailing blanks
+      std::size_t col = text.find_first_not_of(' ', start);
+      if (col >= pos)
+        continue;
+      std::string line = text.substr(col, pos - col);
+      line.erase(line.find_last_not_of(" \t\r\n") + 1);
+      col -= start;
+
+      // continuation of quoted scalar or flow collection
+      // cannot reach back to set list item indentation
+      if (quote || flow) {
+        if (skey != npos && col <= (indent == npos ? skey : indent))
+          return CPCD_FAILURE;
+        ScanScalars(line, quote, flow);
+        continue;
+      }
+
+      // skip empty lines and comments
+      if (line.empty() || line[0] == '#')
+        continue;
+
+      // multiple documents are not supported
+      if (col == 0 && (!line.compare(0, 3, "---") || !line.compare(0, 3, "...")))
+        return CPCD_FAILURE;
+
+      if (skey == npos) {
+        // look for set key
+        if (col > 0 && !line.compare(0, 4, "set:")) {
+          std::size_t c = line.find_first_not_of(" \t", 4);
+          if (c != npos && line[c] != '#')
+            return CPCD_FAILURE;
+          skey   = col;
+          header = pos;
+        }
+      } else if (col < skey || (col == skey && line[0] != '-')) {
+        // content following set list is not supported
+        return CPCD_FAILURE;
+      } else if (line[0] == '-' && (indent == npos || col == indent)) {
+        // new set: retrieve set name
+        if (line.size() < 2 || line[1] != ' ')
+          return CPCD_FAILURE;
+        std::size_t b = line.find_first_not_of(' ', 1);
+        std::size_t e = line.find(':', b);
+        if (e == npos || e == b || (e + 1 < line.size() && line[e+1] != ' '))
+          return CPCD_FAILURE;
+        if (!PlainName(line.substr(b, e - b)))
+          return CPCD_FAILURE;
+        if (!index.empty())
+          index.back().end = start;
+        Offset set;
+        set.name  = line.substr(b, e - b);
+        set.begin = start;
+        set.end   = text.size();
+        index.push_back(set);
+        indent = col;
+      } else if (indent == npos || col <= indent) {
+        return CPCD_FAILURE;
+      }
+      ScanScalars(line, quote, flow);
+    }
+
+    if (header == npos || index.empty() || quote || flow)
+      return CPCD_FAILURE;
+
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::LoadSets (const Node& req)
+  {
+    // load physical constant dictionary sets included in
+    // user request, if not yet loaded, preserving the order
+    // in which sets appear in the dictionary
+    // -- private class method
+    try {
+      if (this->index.empty() || !req.IsMap())
+        return CPCD_SUCCESS;
+
+      bool update = false;
+      for (OffsetList::iterator it=this->index.begin(); it!=this->index.end(); it++) {
+        if (!it->node.IsMap() && req[it->name]) {
+          Node set = YAMLLoad(this->text.substr(it->begin, it->end - it->begin));
+          if (!set.IsSequence() || set.size() != 1 || !set[0].IsMap() ||
+              set[0].size() != 1 || !set[0][it->name])
+            return this->Materialize();
+          if (this->CheckNode(set, it->end - it->begin))
+            return CPCD_FAILURE;
+          it->node = set[0];
+          update = true;
+        }
+      }
+
+      if (update) {
+        Node sets(NodeType::Sequence);
+        for (OffsetList::iterator it=this->index.begin(); it!=this->index.end(); it++) {
+          if (it->node.IsMap())
+            sets.push_back(it->node);
+        }
+        this->doc["physical_constants_dictionary"]["set"] = sets;
+      }
+    } catch (const Exception& e) {
+      // sets cannot be loaded independently: load whole dictionary
+      return this->Materialize();
+    }
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::Materialize () const
+  {
+    // load whole physical constant dictionary if only
+    // some of its sets were loaded in lazy mode
+    // -- private class method
+    try {
+      if (!this->index.empty()) {
+        this->index.clear();
+        this->doc = YAMLLoad(this->text);
+        return this->CheckNode(this->doc, this->text.size());
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+
   // - sanity check
 
   int
   CPCD::ParseReq (const Node& req, Node& preq)
   {
-    // parse YAML user request and return sorted request
+    // parse YAML user request and return sorted request. Set and
+    // constant names are interned and also stored by identifier
     // -- private class method
     try {
       preq = Node(NodeType::Null);  // reset parsed request to empty
-      
-      typedef std::list<std::string> rList;
-      typedef std::map<std::string, rList> rMap;
-      rMap m;
-      
-      // first, order by key
+      this->rsel.clear();
+
+      if (!req.IsMap() && !req.IsNull())
+        return SetError("Requests should be maps of set names to constant names");
+
+      // first, collect by key
       for (Iterator it=req.begin(); it!=req.end(); it++){
+        if (!it->first.IsScalar())
+          return SetError("Requests should use set names as keys");
+        SymbolList& names = this->rsel[this->pool.intern(it->first.Scalar())];
         switch(it->second.Type()) {
           case NodeType::Null:
           case NodeType::Undefined:
           case NodeType::Map:
             return SetError("Requests should not include nested maps");
           case NodeType::Scalar:
-            m[it->first.as<std::string>()].push_back(it->second.as<std::string>());
+            names.push_back(this->pool.intern(it->second.Scalar()));
+            break;
           case NodeType::Sequence:
-            for (int i=0; i<it->second.size(); i++)
-              m[it->first.as<std::string>()].push_back(it->second[i].as<std::string>());
+            for (Iterator il=it->second.begin(); il!=it->second.end(); il++) {
+              if (!il->IsScalar())
+                return SetError("Requests should not include nested lists");
+              names.push_back(this->pool.intern(il->Scalar()));
+            }
+            break;
         }
       }
-      
-      // then order by value
-      for (rMap::iterator it=m.begin(); it!=m.end(); it++) {
-        it->second.sort();
-        it->second.unique(); 
-        for (rList::iterator il=it->second.begin(); il!=it->second.end(); il++)
-          preq[it->first].push_back(*il);
+
+      // then order by key and value
+      const StringPool& pool = this->pool;
+      SymbolList sets;
+      for (SymbolMap::iterator it=this->rsel.begin(); it!=this->rsel.end(); it++)
+        sets.push_back(it->first);
+      std::sort(sets.begin(), sets.end(),
+        [&pool](Symbol lhs, Symbol rhs) { return pool.compare(lhs, rhs) < 0; });
+
+      for (SymbolList::iterator is=sets.begin(); is!=sets.end(); is++) {
+        SymbolList& names = this->rsel[*is];
+        std::sort(names.begin(), names.end(),
+          [&pool](Symbol lhs, Symbol rhs) { return pool.compare(lhs, rhs) < 0; });
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        std::string set(pool.str(*is), pool.length(*is));
+        for (SymbolList::iterator il=names.begin(); il!=names.end(); il++)
+          preq[set].push_back(std::string(pool.str(*il), pool.length(*il)));
+        // identifiers are looked up by value during resolution
+        std::sort(names.begin(), names.end());
       }
-    
+
     } catch (const Exception& e) {
       return SetError(e.what());
     }
@@ -227,6 +826,44 @@ namespace CPCD {
     }
   }
 
+  int
+  CPCD::CheckNode (const Node& node, std::size_t size) const
+  {
+    // check that the number of nodes reachable from input node,
+    // with aliases expanded, is bounded by the size of the YAML
+    // text the node was loaded from, so that alias expansion cannot
+    // make validation, parsing, and emission time super-linear.
+    // Nodes are visited iteratively to bound stack usage
+    // -- private class method
+    try {
+      std::size_t budget = 4 * size + 16;
+      std::vector<Node> stack(1, node);
+      while (!stack.empty()) {
+        Node n = stack.back();
+        stack.pop_back();
+        if (budget-- == 0)
+          return SetError("too many nodes for input size: check for recursive aliases");
+        switch (n.Type()) {
+          case NodeType::Sequence:
+            for (Iterator it=n.begin(); it!=n.end(); it++)
+              stack.push_back(*it);
+            break;
+          case NodeType::Map:
+            for (Iterator it=n.begin(); it!=n.end(); it++) {
+              stack.push_back(it->first);
+              stack.push_back(it->second);
+            }
+            break;
+          default:
+            break;
+        }
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
   int
   CPCD::ValidateNode (const Node& node, const Node& syntax)
   {
@@ -242,9 +879,9 @@ namespace CPCD {
         case NodeType::Scalar:
           break;
         case NodeType::Sequence:
-          for (int i=0; i<syntax.size(); i++) {
-            for (int l=0; l<node.size(); l++) {
-              if (this->ValidateNode(node[l], syntax[i]))
+          for (Iterator is=syntax.begin(); is!=syntax.end(); is++) {
+            for (Iterator it=node.begin(); it!=node.end(); it++) {
+              if (this->ValidateNode(*it, *is))
                 return SetError("unmatched list syntax");
             }
           }
@@ -252,13 +889,18 @@ namespace CPCD {
         case NodeType::Map:
           for (Iterator is=syntax.begin(); is!=syntax.end(); is++) {
             std::string key = is->first.as<std::string>();
-            if (key.compare("VALUE") && node[key]) {
-              if (this->ValidateNode(node[key], is->second))
+            if (key.compare("VALUE")) {
+              // named keys are optional
+              if (node[key] && this->ValidateNode(node[key], is->second))
                 return SetError("map: internal error");
             } else {
-              Iterator it = node.begin();
-              if (this->ValidateNode(it->second, is->second))
-                return SetError("map: internal error");
+              // VALUE matches any key
+              if (node.size() == 0)
+                return SetError("map: missing entries");
+              for (Iterator it=node.begin(); it!=node.end(); it++) {
+                if (this->ValidateNode(it->second, is->second))
+                  return SetError("map: internal error");
+              }
             }
           }
           break;
@@ -275,7 +917,9 @@ namespace CPCD {
     // validate syntax of stored physical constant dictionary
     // -- public class method
     try {
-      this->ValidateNode(this->doc, this->syntax);
+      if (this->Materialize())
+        return SetError("failure loading dictionary");
+      return this->ValidateNode(this->doc, this->syntax);
     } catch (const Exception& e) {
       return SetError(e.what());
     }
@@ -286,45 +930,31 @@ namespace CPCD {
   // - parse
 
   int
-  CPCD::ParseNode (const Node& node, const Node& req, Node& map)
+  CPCD::ParseNode (const Node& node, const SymbolMap& req, ConstantList& table)
   {
-    // recursive method parsing stored physical constant dictionary
-    // to extract user-requested constants into a key:value map object
+    // parse stored physical constant dictionary sets to extract
+    // user-requested constants into resolved constant table
     // -- private class method
     try {
-      if (!node) {
+      if (!node || node.IsNull()) {
         return CPCD_SUCCESS;
       }
-      if (req.IsSequence()) {
-        if (!node.IsSequence())
+      if (!node.IsSequence())
+        return SetError("parsing mismatch");
+      for (Iterator is=node.begin(); is!=node.end(); is++) {
+        if (!is->IsMap())
           return SetError("parsing mismatch");
-        for (int l=0; l<node.size(); l++) {
-          if (node[l]["name"] && node[l]["value"]) {
-            std::string str = node[l]["name"].as<std::string>();
-            std::string val = node[l]["value"].as<std::string>();
-            for (int i=0; i<req.size(); i++) {
-              if (!str.compare(req[i].as<std::string>())) {
-                Node pair;
-                pair["name"]  = str;
-                pair["value"] = val;
-                std::cerr << ">>> " << str << " = " << val << std::endl;
-                map.push_back(pair);
-              }
-            }
-          }
-        }
-      } else if (req.IsMap()) {
-        if (!node.IsSequence())
-          return SetError("parsing mismatch");
-        for (int i=0; i<node.size(); i++) {
-          for (Iterator it=req.begin(); it!=req.end(); it++) {
-            std::string str = it->first.as<std::string>();
-            if (node[i][str]) {
-              Node m = map[str];
-              if (this->ParseNode(node[i][str]["entries"], it->second, m))
-                return SetError("error parsing set");
-            }
-          }
+        for (Iterator it=is->begin(); it!=is->end(); it++) {
+          if (!it->first.IsScalar())
+            continue;
+          // sets not in user request were never interned
+          SymbolMap::const_iterator ir = req.find(this->pool.find(it->first.Scalar()));
+          if (ir == req.end())
+            continue;
+          if (!it->second.IsMap())
+            return SetError("parsing mismatch");
+          if (this->ParseEntries(it->second, ir->first, ir->second, table))
+            return SetError("error parsing set");
         }
       }
     } catch (const Exception& e) {
@@ -333,17 +963,184 @@ namespace CPCD {
     return CPCD_SUCCESS;
   }
 
+  int
+  CPCD::ParseEntries (const Node& node, Symbol set, const SymbolList& names, ConstantList& table)
+  {
+    // parse entries of a physical constant dictionary set
+    // and add user-requested constants, including their
+    // metadata, to resolved constant table
+    // -- private class method
+    try {
+      Node entries = node["entries"];
+      if (!entries || entries.IsNull()) {
+        return CPCD_SUCCESS;
+      }
+      if (!entries.IsSequence())
+        return SetError("parsing mismatch");
+      Symbol citation = StringPool::npos;
+      for (Iterator ie=entries.begin(); ie!=entries.end(); ie++) {
+        if (!ie->IsMap())
+          continue;
+        Node name  = (*ie)["name"];
+        Node value = (*ie)["value"];
+        if (!name || !value || !name.IsScalar() || !value.IsScalar())
+          continue;
+        Symbol id = this->pool.find(name.Scalar());
+        if (!std::binary_search(names.begin(), names.end(), id))
+          continue;
+        if (citation == StringPool::npos)
+          citation = this->InternField(node, "citation");
+        Constant c;
+        c.set   = set;
+        c.name  = id;
+        c.value = this->pool.intern(value.Scalar());
+        c.units       = this->InternField(*ie, "units");
+        c.prec        = this->InternField(*ie, "prec");
+        c.type        = this->InternField(*ie, "type");
+        c.uncertainty = this->InternField(*ie, "uncertainty");
+        c.relative_uncertainty = this->InternField(*ie, "relative_uncertainty");
+        c.description = this->InternField(*ie, "description");
+        c.citation    = citation;
+        if (this->verbose)
+          std::cerr << ">>> " << name.Scalar() << " = " << value.Scalar() << std::endl;
+        table.push_back(c);
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+  StringPool::Symbol
+  CPCD::InternField (const Node& node, const std::string& key)
+  {
+    // intern scalar value of map node field, without
+    // leading and trailing blanks, or return npos if
+    // field is not available
+    // -- private class method
+    Node field = node[key];
+    if (!field || !field.IsScalar())
+      return StringPool::npos;
+    const std::string& str = field.Scalar();
+    std::size_t b = str.find_first_not_of(" \t\n");
+    if (b == std::string::npos)
+      return this->pool.intern(std::string());
+    std::size_t e = str.find_last_not_of(" \t\n");
+    return this->pool.intern(str.substr(b, e - b + 1));
+  }
+
   int
   CPCD::parse ()
   {
     // parse stored physical constant dictionary to extract
-    // user-requested constants into a key:value map object
+    // user-requested constants into resolved constant table
     // -- public class method
     try {
-      std::cout << "Parsing ..." << std::endl;
-      if (this->ParseNode(this->doc["physical_constants_dictionary"]["set"], this->sel, this->map))
+      if (this->verbose)
+        std::cout << "Parsing ..." << std::endl;
+      if (this->LoadSets(this->sel))
+        return SetError("failure loading dictionary sets");
+      this->table.clear();
+      if (this->ParseNode(this->doc["physical_constants_dictionary"]["set"], this->rsel, this->table))
         return SetError("parse error");
-      std::cout << this->map << std::endl;
+
+      // group constants by set, in order of first appearance
+      std::map<Symbol, std::size_t> rank;
+      for (ConstantList::iterator it=this->table.begin(); it!=this->table.end(); it++)
+        rank.insert(std::make_pair(it->set, rank.size()));
+      std::stable_sort(this->table.begin(), this->table.end(),
+        [&rank](const Constant& lhs, const Constant& rhs) { return rank[lhs.set] < rank[rhs.set]; });
+
+      if (this->verbose) {
+        this->emitY(std::cout, this->table);
+        std::cout << std::endl;
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+
+  // - verify
+
+  int
+  CPCD::verify () const
+  {
+    // verify that the literal emitted for each resolved physical
+    // constant parses back to the value of its dictionary decimal
+    // string in each requested precision: the precision of the
+    // emitted Fortran kind and the precision listed in the dictionary.
+    // Literals are normalized first, then converted and checked for
+    // each precision in a single pass over the resolved constant table.
+    // Constants losing precision are reported as warnings, invalid or
+    // out-of-range literals as errors
+    // -- public class method
+    try {
+      std::size_t n = this->table.size();
+      std::vector<std::string> lit(n);
+      std::vector<Decimal>     dec(n);
+      std::vector<bool>        single(n, false), dbl(n, true), quad(n, false);
+      std::vector<int>         fstatus(n, 0), dstatus(n, 0), qstatus(n, 0);
+      int rc = CPCD_SUCCESS;
+
+      // normalize literals and collect requested precisions
+      for (std::size_t i=0; i<n; i++) {
+        const Constant& c = this->table[i];
+        lit[i] = this->pool.str(c.value);
+        std::replace(lit[i].begin(), lit[i].end(), 'd', 'e');
+        std::replace(lit[i].begin(), lit[i].end(), 'D', 'e');
+        dec[i] = ParseDecimal(lit[i].c_str());
+        if (!dec[i].valid) {
+          dbl[i] = false;
+          rc = SetError(std::string(this->pool.str(c.set)) + "_" + this->pool.str(c.name) +
+                        " = " + this->pool.str(c.value) + ": not a valid number");
+          continue;
+        }
+        if (c.prec == StringPool::npos)
+          continue;
+        std::string prec = this->pool.str(c.prec);
+        if (!prec.compare("single") || !prec.compare("float"))
+          single[i] = true;
+        else if (!prec.compare("quad") || !prec.compare("extended"))
+          quad[i] = true;
+        else if (prec.compare("double"))
+          std::cerr << "Warning: " << this->pool.str(c.set) << "_" << this->pool.str(c.name)
+                    << ": unknown precision " << prec << std::endl;
+      }
+
+      // convert and check in bulk for each precision
+      RoundTrip<float>      (dec, lit, single, fstatus);
+      RoundTrip<double>     (dec, lit, dbl,    dstatus);
+      RoundTrip<long double>(dec, lit, quad,   qstatus);
+
+      // report
+      std::size_t inexact = 0;
+      for (std::size_t i=0; i<n; i++) {
+        const Constant& c = this->table[i];
+        const std::pair<const char*, int> status[] = {
+          std::make_pair("single",   fstatus[i]),
+          std::make_pair("double",   dstatus[i]),
+          std::make_pair("extended", qstatus[i])
+        };
+        std::string symbol = std::string(this->pool.str(c.set)) + "_" + this->pool.str(c.name);
+        bool lost = false;
+        for (std::size_t k=0; k<sizeof(status)/sizeof(status[0]); k++) {
+          if (status[k].second == 2) {
+            rc = SetError(symbol + " = " + this->pool.str(c.value) +
+                          ": out of range in " + status[k].first + " precision");
+          } else if (status[k].second == 1) {
+            std::cerr << "Warning: " << symbol << " = " << this->pool.str(c.value)
+                      << ": not exact in " << status[k].first << " precision" << std::endl;
+            lost = true;
+          }
+        }
+        if (lost)
+          inexact++;
+      }
+      if (this->verbose)
+        std::cout << inexact << " of " << n << " constants lose precision" << std::endl;
+      return rc;
     } catch (const Exception& e) {
       return SetError(e.what());
     }
@@ -354,7 +1151,7 @@ namespace CPCD {
   // - emit
 
   int
-  CPCD::emitF (std::ostream& os, const Node& map) const
+  CPCD::emitF (std::ostream& os, const ConstantList& table) const
   {
     // emit Fortran module file including user-requested
     // physical constants to output stream object
@@ -370,20 +1167,19 @@ namespace CPCD {
          << " = kind(1.d0)"
          << std::endl
          << std::endl;
-      for (Iterator is=map.begin(); is!=map.end(); is++) {
-        os << "! - from set " << is->first << std::endl;
-        for (int i=0; i<is->second.size(); i++) {
-          os << _CPCD_FORTRAN_INDENT
-             << "real("
-             << _CPCD_FORTRAN_KIND
-             << "), parameter :: "
-             << is->first << "_"
-             << is->second[i]["name"]
-             << " = " 
-             << is->second[i]["value"]
-             << "_" << _CPCD_FORTRAN_KIND
-             << std::endl;
-        }
+      for (ConstantList::const_iterator it=table.begin(); it!=table.end(); it++) {
+        if (it == table.begin() || it->set != (it-1)->set)
+          os << "! - from set " << this->pool.str(it->set) << std::endl;
+        os << _CPCD_FORTRAN_INDENT
+           << "real("
+           << _CPCD_FORTRAN_KIND
+           << "), parameter :: "
+           << this->pool.str(it->set) << "_"
+           << this->pool.str(it->name)
+           << " = " 
+           << this->pool.str(it->value)
+           << "_" << _CPCD_FORTRAN_KIND
+           << std::endl;
       }
       os << std::endl;
       os << "end module "
@@ -395,21 +1191,296 @@ namespace CPCD {
     return CPCD_SUCCESS;
   }
 
+  int
+  CPCD::emitY (std::ostream& os, const ConstantList& table) const
+  {
+    // emit user-requested physical constants
+    // as YAML set:[{name, value}] map to output stream object
+    // -- private class method
+    try {
+      YAML::Emitter out(os);
+      out << YAML::BeginMap;
+      for (ConstantList::const_iterator it=table.begin(); it!=table.end(); it++) {
+        if (it == table.begin() || it->set != (it-1)->set) {
+          if (it != table.begin())
+            out << YAML::EndSeq;
+          out << YAML::Key << this->pool.str(it->set) << YAML::Value << YAML::BeginSeq;
+        }
+        out << YAML::BeginMap
+            << YAML::Key << "name"  << YAML::Value << this->pool.str(it->name)
+            << YAML::Key << "value" << YAML::Value << this->pool.str(it->value)
+            << YAML::EndMap;
+      }
+      if (!table.empty())
+        out << YAML::EndSeq;
+      out << YAML::EndMap;
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
   int
   CPCD::femit (const std::string& filename) const
   {
     // emit Fortran module file including user-requested
-    // physical constants to file
+    // physical constants to file. File is left untouched
+    // if its content is unchanged
     // -- public class method
-    int rc = CPCD_SUCCESS;
     try {
-      std::ofstream of(filename);
-      rc = this->emitF(of, this->map);
-      of.close();
+      std::ostringstream os;
+      int rc = this->emitF(os, this->table);
+      if (rc != CPCD_SUCCESS)
+        return rc;
+      return WriteFile(filename, os.str());
     } catch (const Exception& e) {
       return SetError(e.what());
     }
-    return rc;
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::femit (std::ostream& os) const
+  {
+    // emit Fortran module file including user-requested
+    // physical constants to output stream object
+    // -- public class method
+    return this->emitF(os, this->table);
+  }
+
+  int
+  CPCD::emitJ (std::ostream& os, const ConstantList& table) const
+  {
+    // emit provenance metadata of user-requested physical
+    // constants as JSON to output stream object: dictionary
+    // version and content hash, then one record per constant
+    // -- private class method
+    try {
+      const Node& d = this->doc;
+      Node version = d["physical_constants_dictionary"]["version_number"];
+      std::ostringstream hash;
+      hash << std::hex;
+      hash.width(16);
+      hash.fill('0');
+      hash << this->checksum;
+
+      os << "{" << std::endl;
+      os << "  \"dictionary\": { \"version_number\": ";
+      WriteJSON(os, (version && version.IsScalar()) ? version.Scalar().c_str() : "");
+      os << ", \"hash\": \"fnv1a64:" << hash.str() << "\" }," << std::endl;
+      os << "  \"constants\": [" << std::endl;
+      for (ConstantList::const_iterator it=table.begin(); it!=table.end(); it++) {
+        const std::pair<const char*, Symbol> fields[] = {
+          std::make_pair("units",                it->units),
+          std::make_pair("prec",                 it->prec),
+          std::make_pair("type",                 it->type),
+          std::make_pair("uncertainty",          it->uncertainty),
+          std::make_pair("relative_uncertainty", it->relative_uncertainty),
+          std::make_pair("description",          it->description),
+          std::make_pair("citation",             it->citation)
+        };
+        os << "    { \"set\": ";
+        WriteJSON(os, this->pool.str(it->set));
+        os << ", \"name\": ";
+        WriteJSON(os, this->pool.str(it->name));
+        os << ", \"value\": ";
+        WriteJSON(os, this->pool.str(it->value));
+        for (std::size_t i=0; i<sizeof(fields)/sizeof(fields[0]); i++) {
+          if (fields[i].second == StringPool::npos)
+            continue;
+          os << ", \"" << fields[i].first << "\": ";
+          WriteJSON(os, this->pool.str(fields[i].second));
+        }
+        os << " }" << ((it+1 != table.end()) ? "," : "") << std::endl;
+      }
+      os << "  ]" << std::endl;
+      os << "}" << std::endl;
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::memit (const std::string& filename) const
+  {
+    // emit provenance metadata of user-requested
+    // physical constants as JSON to file. File is left
+    // untouched if its content is unchanged
+    // -- public class method
+    try {
+      std::ostringstream os;
+      int rc = this->emitJ(os, this->table);
+      if (rc != CPCD_SUCCESS)
+        return rc;
+      return WriteFile(filename, os.str());
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::memit (std::ostream& os) const
+  {
+    // emit provenance metadata of user-requested
+    // physical constants as JSON to output stream object
+    // -- public class method
+    return this->emitJ(os, this->table);
+  }
+
+
+  int
+  CPCD::demit (const std::string& filename, const std::string& stamp) const
+  {
+    // emit make/ninja dependency file listing physical constant
+    // dictionary and user request files as prerequisites of stamp
+    // target, then update stamp. Generated files are only rewritten
+    // if changed, so stamp stands for them as single target that is
+    // always newer than its prerequisites. Dependency file is left
+    // untouched if its content is unchanged
+    // -- public class method
+    std::ostringstream os;
+    os << MakeEscape(stamp) << ":";
+    if (!this->dictfile.empty())
+      os << " " << MakeEscape(this->dictfile);
+    if (!this->reqfile.empty())
+      os << " " << MakeEscape(this->reqfile);
+    os << std::endl;
+    if (WriteFile(filename, os.str()))
+      return CPCD_FAILURE;
+
+    std::ofstream of(stamp, std::ios::trunc);
+    of.close();
+    if (!of)
+      return SetError("unable to write file: " + stamp);
+    return CPCD_SUCCESS;
+  }
+
+
+  // - compare
+
+  int
+  CPCD::HashNode (const Node& node, RecordMap& records) const
+  {
+    // compute hashed records for each set of the physical
+    // constant dictionary and for each entry within a set.
+    // Entry hashes include set fields other than entries,
+    // which are emitted with each constant
+    // -- private class method
+    try {
+      records.clear();
+      if (!node) {
+        return CPCD_SUCCESS;
+      }
+      if (!node.IsSequence())
+        return SetError("hashing mismatch");
+      for (Iterator is=node.begin(); is!=node.end(); is++) {
+        for (Iterator it=is->begin(); it!=is->end(); it++) {
+          Record& rec = records[it->first.as<std::string>()];
+          rec.hash = HashString(YAMLDump(it->second));
+          Node entries = it->second["entries"];
+          if (!entries.IsSequence())
+            continue;
+          std::string fields;
+          if (it->second.IsMap()) {
+            for (Iterator ik=it->second.begin(); ik!=it->second.end(); ik++) {
+              if (!ik->first.IsScalar() || ik->first.Scalar() != "entries")
+                fields += YAMLDump(ik->first) + "\n" + YAMLDump(ik->second) + "\n";
+            }
+          }
+          for (Iterator ie=entries.begin(); ie!=entries.end(); ie++) {
+            if ((*ie)["name"])
+              rec.entries[(*ie)["name"].as<std::string>()] = HashString(fields + YAMLDump(*ie));
+          }
+        }
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
+  }
+
+  int
+  CPCD::diff (const CPCD& ref, Node& changes) const
+  {
+    // compare stored physical constant dictionary with reference
+    // dictionary set by set, then entry by entry, using hashed
+    // records. Changed constants are returned as set:{name:status}
+    // map, with status being one of: added, removed, modified.
+    // If a user request is loaded, only requested constants are
+    // compared, so that an empty request has no changes
+    // -- public class method
+    try {
+      changes = Node(NodeType::Null);  // reset changes to empty
+
+      if (this->Materialize())
+        return SetError("failure loading dictionary");
+      if (ref.Materialize())
+        return SetError("failure loading reference dictionary");
+
+      RecordMap lhs, rhs;
+      if (this->HashNode(this->doc["physical_constants_dictionary"]["set"], lhs))
+        return SetError("failure hashing dictionary");
+      if (ref.HashNode(ref.doc["physical_constants_dictionary"]["set"], rhs))
+        return SetError("failure hashing reference dictionary");
+
+      // collect sets to compare
+      typedef std::list<std::string> rList;
+      rList sets;
+      if (this->reqset) {
+        for (Iterator it=this->sel.begin(); it!=this->sel.end(); it++)
+          sets.push_back(it->first.as<std::string>());
+      } else {
+        for (RecordMap::const_iterator ir=lhs.begin(); ir!=lhs.end(); ir++)
+          sets.push_back(ir->first);
+        for (RecordMap::const_iterator ir=rhs.begin(); ir!=rhs.end(); ir++)
+          sets.push_back(ir->first);
+        sets.sort();
+        sets.unique();
+      }
+
+      for (rList::iterator is=sets.begin(); is!=sets.end(); is++) {
+        RecordMap::const_iterator l = lhs.find(*is);
+        RecordMap::const_iterator r = rhs.find(*is);
+        // skip unchanged sets
+        if (l != lhs.end() && r != rhs.end() && l->second.hash == r->second.hash)
+          continue;
+
+        // collect entries to compare
+        rList names;
+        if (this->reqset) {
+          Node list = this->sel[*is];
+          for (Iterator it=list.begin(); it!=list.end(); it++)
+            names.push_back(it->as<std::string>());
+        } else {
+          if (l != lhs.end())
+            for (HashMap::const_iterator ie=l->second.entries.begin(); ie!=l->second.entries.end(); ie++)
+              names.push_back(ie->first);
+          if (r != rhs.end())
+            for (HashMap::const_iterator ie=r->second.entries.begin(); ie!=r->second.entries.end(); ie++)
+              names.push_back(ie->first);
+          names.sort();
+          names.unique();
+        }
+
+        for (rList::iterator in=names.begin(); in!=names.end(); in++) {
+          HashMap::const_iterator le, re;
+          bool inl = (l != lhs.end()) && ((le = l->second.entries.find(*in)) != l->second.entries.end());
+          bool inr = (r != rhs.end()) && ((re = r->second.entries.find(*in)) != r->second.entries.end());
+          if (inl && !inr) {
+            changes[*is][*in] = "added";
+          } else if (!inl && inr) {
+            changes[*is][*in] = "removed";
+          } else if (inl && inr && le->second != re->second) {
+            changes[*is][*in] = "modified";
+          }
+        }
+      }
+    } catch (const Exception& e) {
+      return SetError(e.what());
+    }
+    return CPCD_SUCCESS;
   }
 
 } // namespace CPCD
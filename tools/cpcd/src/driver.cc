@@ -24,14 +24,31 @@ static void
 print_usage (int status)
 {
   std::cerr << "Usage: " << PACKAGE << " [options] ..." << std::endl;
+  std::cerr << "  or:  " << PACKAGE << " [options] diff REF_YAML [REQUEST_YAML ...]" << std::endl;
   std::cerr << "Main tool to validate, parse, and extract physical constant sets" << std::endl;
   std::cerr << "from the Community Physical Constant Dictionary" << std::endl;
   std::cerr << std::endl;
+  std::cerr << "The diff command compares the dictionary with the reference dictionary" << std::endl;
+  std::cerr << "REF_YAML and lists added, removed, and modified constants. If request" << std::endl;
+  std::cerr << "files are provided, only requests affected by changes are listed." << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Output files are only rewritten if their content changes. With -M," << std::endl;
+  std::cerr << "OUTPUT.stamp is updated on each run and stands for all output files" << std::endl;
+  std::cerr << "in build rules, e.g. for make:" << std::endl;
+  std::cerr << "  cpcd_mod.F90.stamp:" << std::endl;
+  std::cerr << "  \t" << PACKAGE << " -M -d pcd.yaml -r req.yaml -o cpcd_mod.F90" << std::endl;
+  std::cerr << "  cpcd_mod.F90: cpcd_mod.F90.stamp ;" << std::endl;
+  std::cerr << "  -include cpcd_mod.F90.d" << std::endl;
+  std::cerr << std::endl;
   std::cerr << "Mandatory arguments to long options are mandatory for short options too." << std::endl;
   std::cerr << "  -d, --dictionary YAML_FILE      Use YAML_FILE as dictionary" << std::endl;
   std::cerr << "  -r, --request    YAML_FILE      Extract constants listed in YAML_FILE" << std::endl;
   std::cerr << "  -o, --output     FILE           Save Fortran output to FILE" << std::endl;
+  std::cerr << "  -m, --metadata   FILE           Save metadata of output constants to JSON FILE" << std::endl;
+  std::cerr << "  -M, --depend                    Save make dependencies of OUTPUT.stamp to OUTPUT.d" << std::endl;
   std::cerr << "  -x, --validate                  Validate dictionary file before proceeding" << std::endl;
+  std::cerr << "  -l, --lazy                      Load dictionary sets only when requested" << std::endl;
+  std::cerr << "  -c, --check                     Check that output constants are exact in their precision" << std::endl;
   std::cerr << "  -v, --verbose                   Use verbose output" << std::endl;
   std::cerr << "  -V, --version                   Print version information" << std::endl;
   std::cerr << "  -h, --help                      Display available options" << std::endl;
@@ -68,11 +85,15 @@ main (int argc, char** argv)
   std::string pcd_file = "pcd.yaml";        // Physical constant dictionary YAML file
   std::string req_file = "req.yaml";        // User-provided YAML file with requested constants
   std::string out_file = "cpcd_mod.F90";    // Fortran module file
+  std::string met_file;                     // JSON metadata file (optional)
 
   // Control flags
   int validate = 0;
   int verbose  = 0;
   int print    = 0;
+  int lazy     = 0;
+  int depend   = 0;
+  int check    = 0;
 
   // Define command-line options
   static struct option options[] =
@@ -83,8 +104,12 @@ main (int argc, char** argv)
     { "verbose",     no_argument,        &verbose,    1  },
     { "validate",    no_argument,        &validate,   1  },
     { "print",       no_argument,        &print,      1  },
+    { "lazy",        no_argument,        &lazy,       1  },
+    { "depend",      no_argument,        &depend,     1  },
+    { "check",       no_argument,        &check,      1  },
     { "request",     required_argument,  NULL,       'r' },
     { "output",      required_argument,  NULL,       'o' },
+    { "metadata",    required_argument,  NULL,       'm' },
     { "dictionary",  required_argument,  NULL,       'd' },
     // Mark end of table
     { NULL,          0,                  NULL,       0   }
@@ -93,7 +118,7 @@ main (int argc, char** argv)
   /* Parse command-line options */
   int c = 0;
 
-  while ((c = getopt_long (argc, argv, "hvVvxpr:o:d:", options, NULL)) != -1)
+  while ((c = getopt_long (argc, argv, "hvVvxplMcr:o:m:d:", options, NULL)) != -1)
     {
       switch(c)
         {
@@ -112,12 +137,24 @@ main (int argc, char** argv)
         case 'p':
           print = 1;
           break;
+        case 'l':
+          lazy = 1;
+          break;
+        case 'M':
+          depend = 1;
+          break;
+        case 'c':
+          check = 1;
+          break;
         case 'r':
           req_file = optarg;
           break;
         case 'o':
           out_file = optarg;
           break;
+        case 'm':
+          met_file = optarg;
+          break;
         case 'd':
           pcd_file = optarg;
           break;
@@ -131,13 +168,22 @@ main (int argc, char** argv)
   argc -= optind;
   argv += optind;
 
+  // Check for diff command among remaining arguments
+  bool compare = (argc > 0 && !std::string(argv[0]).compare("diff"));
+
   // Abort if there are remaining arguments after parsing known command-line options
-  if (optind == 1 || argc > 1) {
+  if (compare) {
+    if (argc < 2) {
+      print_usage(CPCD_FAILURE);
+    }
+  } else if (optind == 1 || argc > 1) {
     print_usage(CPCD_FAILURE);
   }
 
   /* Create dictionary instance */
   CPCD::CPCD doc;
+  doc.lazy    = lazy;
+  doc.verbose = verbose;
 
   /* Read physical constant dictionary */
   int rc = doc.read (pcd_file);
@@ -167,6 +213,43 @@ main (int argc, char** argv)
     return rc;
   }
 
+  // Compare dictionary with reference dictionary if requested
+  if (compare) {
+    CPCD::CPCD ref;
+    rc = ref.read (argv[1]);
+    if (rc != CPCD_SUCCESS) {
+      return rc;
+    }
+    CPCD::Node changes;
+    if (argc == 2) {
+      // list all changed constants
+      rc = doc.diff (ref, changes);
+      if (rc != CPCD_SUCCESS) {
+        return rc;
+      }
+    } else {
+      // list changed constants for each affected request
+      for (int i=2; i<argc; i++) {
+        rc = doc.readreq (argv[i]);
+        if (rc != CPCD_SUCCESS) {
+          return rc;
+        }
+        CPCD::Node reqchanges;
+        rc = doc.diff (ref, reqchanges);
+        if (rc != CPCD_SUCCESS) {
+          return rc;
+        }
+        if (reqchanges.size() > 0) {
+          changes[std::string(argv[i])] = reqchanges;
+        }
+      }
+    }
+    if (changes.size() > 0) {
+      std::cout << changes << std::endl;
+    }
+    return CPCD_SUCCESS;
+  }
+
   // Read YAML file containing user-requested constants
   rc = doc.readreq (req_file);
   if (rc != CPCD_SUCCESS) {
@@ -197,11 +280,35 @@ main (int argc, char** argv)
     return rc;
   }
 
+  // Verify that requested constants round-trip in their precision
+  if (check) {
+    rc = doc.verify ();
+    if (rc != CPCD_SUCCESS) {
+      return rc;
+    }
+  }
+
   // Emit Fortran module defining requested physical constants
   rc = doc.femit (out_file);
   if (rc != CPCD_SUCCESS) {
     return rc;
   }
+
+  // Emit provenance metadata of requested constants if requested
+  if (!met_file.empty()) {
+    rc = doc.memit (met_file);
+    if (rc != CPCD_SUCCESS) {
+      return rc;
+    }
+  }
+
+  // Emit dependency file for generated files if requested
+  if (depend) {
+    rc = doc.demit (out_file + ".d", out_file + ".stamp");
+    if (rc != CPCD_SUCCESS) {
+      return rc;
+    }
+  }
   
   return CPCD_SUCCESS;
 }
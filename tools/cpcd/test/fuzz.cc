@@ -0,0 +1,75 @@
+/*  Fuzz - libFuzzer entry point for the CPCD loader and resolver
+    Copyright (C) 2019  National Earth System Prediction Capability/CSC
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/*  Build with clang from the top source directory, e.g.:
+
+      clang++ -std=c++11 -g -fsanitize=fuzzer,address -I include \
+        test/fuzz.cc src/cpcd.cc -lyaml-cpp -o cpcd-fuzz
+
+    Each input holds a dictionary and a request, separated by a line
+    containing only %%. The first byte selects lazy loading. Inputs
+    slower than -timeout are reported by libFuzzer as timeouts. */
+
+#include "cpcd.h"
+
+#include <cstdint>
+#include <cstring>
+
+#define FUZZ_SEPARATOR "\n%%\n"
+
+
+extern "C" int
+LLVMFuzzerTestOneInput (const uint8_t* data, size_t size)
+{
+  if (size < 1)
+    return 0;
+
+  // split input into dictionary and request
+  std::string input(reinterpret_cast<const char*>(data) + 1, size - 1);
+  std::string dictionary = input;
+  std::string request;
+  std::size_t sep = input.find(FUZZ_SEPARATOR);
+  if (sep != std::string::npos) {
+    dictionary = input.substr(0, sep);
+    request    = input.substr(sep + std::strlen(FUZZ_SEPARATOR));
+  }
+
+  // silence error messages
+  std::ostringstream log;
+  std::streambuf* buf = std::cerr.rdbuf(log.rdbuf());
+
+  CPCD::CPCD doc;
+  doc.lazy = data[0] & 1;
+
+  if (doc.load (dictionary) == CPCD_SUCCESS) {
+    if (doc.loadreq (request) == CPCD_SUCCESS) {
+      if (doc.parse () == CPCD_SUCCESS) {
+        std::ostringstream os;
+        doc.verify ();
+        doc.femit (os);
+        doc.memit (os);
+      }
+      CPCD::CPCD ref;
+      CPCD::Node changes;
+      if (ref.load (dictionary) == CPCD_SUCCESS)
+        doc.diff (ref, changes);
+    }
+    doc.validate ();
+  }
+
+  std::cerr.rdbuf(buf);
+  return 0;
+}
@@ -0,0 +1,48 @@
+#!/bin/sh
+# Golden-output test for the CPCD parser tool: emit the Fortran module
+# and JSON metadata for req.yaml from the top-level dictionary, in full
+# and lazy mode, and compare with reference output in golden/. Also
+# compare warnings of literal verification (--check).
+# The dictionary hash is masked in the JSON metadata.
+#
+# To update reference output after an intended change, copy the files
+# left in golden.tmp/ by a failing run to golden/.
+
+CPCD=${CPCD:-../src/cpcd}
+PCD_YAML=${PCD_YAML:-$srcdir/../../../pcd.yaml}
+
+# skip if dictionary is not available, e.g. in distribution tarballs
+if test ! -f "$PCD_YAML"; then
+  echo "Dictionary not found: $PCD_YAML"
+  exit 77
+fi
+
+tmp=golden.tmp
+rm -rf $tmp
+mkdir $tmp || exit 1
+
+rc=0
+$CPCD --validate -d "$PCD_YAML" || rc=1
+
+for mode in "" --lazy; do
+  echo "Emitting constants ${mode:-(full)}"
+  $CPCD $mode --depend -d "$PCD_YAML" -r "$srcdir/req.yaml" \
+    -o $tmp/cpcd_mod.F90 -m $tmp/cpcd_mod.json || rc=1
+  sed 's/fnv1a64:[0-9a-f]*/fnv1a64:HASH/' $tmp/cpcd_mod.json > $tmp/cpcd_mod.json.masked
+  mv $tmp/cpcd_mod.json.masked $tmp/cpcd_mod.json
+  diff -u "$srcdir/golden/cpcd_mod.F90"  $tmp/cpcd_mod.F90  || rc=1
+  diff -u "$srcdir/golden/cpcd_mod.json" $tmp/cpcd_mod.json || rc=1
+  grep -q "^$tmp/cpcd_mod.F90.stamp: " $tmp/cpcd_mod.F90.d || rc=1
+  test -f $tmp/cpcd_mod.F90.stamp || rc=1
+done
+
+# literals not exact in their precision are reported as warnings
+$CPCD --check -d "$PCD_YAML" -r "$srcdir/req.yaml" -o $tmp/check.F90 2> $tmp/check.err || rc=1
+diff -u "$srcdir/golden/check.err" $tmp/check.err || rc=1
+
+# dictionary compared with itself has no changes
+changes=`$CPCD -d "$PCD_YAML" diff "$PCD_YAML" "$srcdir/req.yaml"` || rc=1
+test -z "$changes" || rc=1
+
+test $rc -eq 0 && rm -rf $tmp
+exit $rc
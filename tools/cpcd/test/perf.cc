@@ -0,0 +1,242 @@
+/*  Perf - Performance gate for the CPCD loader, resolver, and emitter
+    Copyright (C) 2019  National Earth System Prediction Capability/CSC
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/*  Generates a large synthetic dictionary, then measures the cost of
+    each phase relative to a calibration run in the same process (best
+    of PERF_REPEAT runs):
+    - read:  full dictionary load;
+    - lazy:  lazy dictionary load and parse of a single set;
+    - parse: resolution of a request listing every constant;
+    - emit:  Fortran module and JSON metadata emission.
+    The calibration times reference work of similar nature on the same
+    dictionary: loading it with yaml-cpp (for read and emit), visiting
+    every loaded node (for parse), and splitting its text into lines
+    (for lazy). Since it runs on the same host, with the same build
+    flags, relative costs depend little on host speed, optimization,
+    or instrumentation, and detect slowdowns of cpcd itself.
+
+    Relative costs are compared with maximum values listed in the
+    baseline file perf.baseline, found in $srcdir. The run fails if any
+    phase exceeds its baseline.
+
+    Usage: perf [--record FILE]
+    With --record, measured relative costs multiplied by PERF_MARGIN
+    are written to FILE as new baseline. Record a new baseline after
+    an intended change in cost, e.g. from the build directory:
+
+      test/perf --record $srcdir/test/perf.baseline */
+
+#include "cpcd.h"
+#include "synthetic.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#define PERF_SETS    1000
+#define PERF_ENTRIES 10
+#define PERF_REPEAT  5
+#define PERF_SEED    2019
+#define PERF_MARGIN  4.0
+
+
+namespace {
+
+  typedef std::chrono::steady_clock Clock;
+
+  double
+  Seconds (const Clock::time_point& start)
+  {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+  }
+
+  std::size_t
+  Visit (const CPCD::Node& node)
+  {
+    // visit every node, looking up map values by key,
+    // and return total size of scalars
+    std::size_t size = 0;
+    if (node.IsScalar()) {
+      size = node.Scalar().size();
+    } else if (node.IsSequence()) {
+      for (CPCD::Iterator it=node.begin(); it!=node.end(); it++)
+        size += Visit(*it);
+    } else if (node.IsMap()) {
+      for (CPCD::Iterator it=node.begin(); it!=node.end(); it++)
+        size += Visit(it->first) + Visit(node[it->first.Scalar()]);
+    }
+    return size;
+  }
+
+  std::size_t
+  Scan (const std::string& text)
+  {
+    // split text into lines without indentation,
+    // and return total size of lines
+    std::size_t size = 0;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      std::size_t start = pos;
+      pos = text.find('\n', start);
+      pos = (pos == std::string::npos) ? text.size() : pos + 1;
+      std::size_t col = text.find_first_not_of(' ', start);
+      if (col < pos)
+        size += text.substr(col, pos - col).size();
+    }
+    return size;
+  }
+
+  int
+  Calibrate (const std::string& text, std::map<std::string, double>& reference)
+  {
+    // time reference work of the same build on the same dictionary:
+    // - load: load dictionary with yaml-cpp;
+    // - visit: visit every node of loaded dictionary;
+    // - scan: split dictionary text into lines
+    Clock::time_point start = Clock::now();
+    CPCD::Node doc = CPCD::YAMLLoad(text);
+    reference["load"] = Seconds(start);
+
+    start = Clock::now();
+    if (Visit(doc) == 0)
+      return CPCD_FAILURE;
+    reference["visit"] = Seconds(start);
+
+    start = Clock::now();
+    if (Scan(text) == 0)
+      return CPCD_FAILURE;
+    reference["scan"] = Seconds(start);
+
+    for (std::map<std::string, double>::iterator it=reference.begin(); it!=reference.end(); it++) {
+      if (it->second <= 0.0)
+        return CPCD_FAILURE;
+    }
+    return CPCD_SUCCESS;
+  }
+
+  std::string
+  Request (const Synthetic::Dictionary& dict)
+  {
+    // write request for all constants of dictionary
+    std::ostringstream os;
+    for (Synthetic::Dictionary::const_iterator is=dict.begin(); is!=dict.end(); is++) {
+      os << is->name << ": [";
+      for (std::vector<Synthetic::Entry>::const_iterator ie=is->entries.begin(); ie!=is->entries.end(); ie++)
+        os << (ie == is->entries.begin() ? " " : ", ") << ie->name;
+      os << " ]\n";
+    }
+    return os.str();
+  }
+
+} // namespace
+
+
+int
+main (int argc, char** argv)
+{
+  std::string record;
+  if (argc == 3 && !std::strcmp(argv[1], "--record")) {
+    record = argv[2];
+  } else if (argc != 1) {
+    std::cerr << "Usage: perf [--record FILE]" << std::endl;
+    return CPCD_FAILURE;
+  }
+
+  Synthetic::Random rng(PERF_SEED);
+  Synthetic::Dictionary dict = Synthetic::Generate(rng, PERF_SETS, PERF_ENTRIES);
+  std::string text    = Synthetic::Format(dict);
+  std::string request = Request(dict);
+
+  std::map<std::string, double> best;
+  for (int rep=0; rep<PERF_REPEAT; rep++) {
+    std::map<std::string, double> cost;
+    std::ostringstream os;
+
+    std::map<std::string, double> reference;
+    if (Calibrate (text, reference) != CPCD_SUCCESS)
+      return CPCD_FAILURE;
+
+    CPCD::CPCD doc;
+    Clock::time_point start = Clock::now();
+    if (doc.load (text) != CPCD_SUCCESS)
+      return CPCD_FAILURE;
+    cost["read"] = Seconds(start) / reference["load"];
+
+    start = Clock::now();
+    if (doc.loadreq (request) != CPCD_SUCCESS || doc.parse () != CPCD_SUCCESS)
+      return CPCD_FAILURE;
+    cost["parse"] = Seconds(start) / reference["visit"];
+
+    start = Clock::now();
+    if (doc.femit (os) != CPCD_SUCCESS || doc.memit (os) != CPCD_SUCCESS)
+      return CPCD_FAILURE;
+    cost["emit"] = Seconds(start) / reference["load"];
+
+    CPCD::CPCD lazy;
+    lazy.lazy = 1;
+    start = Clock::now();
+    if (lazy.load (text) != CPCD_SUCCESS || lazy.loadreq ("SET0: constant_0") != CPCD_SUCCESS ||
+        lazy.parse () != CPCD_SUCCESS)
+      return CPCD_FAILURE;
+    cost["lazy"] = Seconds(start) / reference["scan"];
+
+    for (std::map<std::string, double>::iterator it=cost.begin(); it!=cost.end(); it++) {
+      if (rep == 0 || it->second < best[it->first])
+        best[it->first] = it->second;
+    }
+  }
+
+  // record new baseline if requested
+  if (!record.empty()) {
+    std::ofstream of(record);
+    of << "# Maximum cost of cpcd phases, relative to reference work of the" << std::endl
+       << "# same build (see perf.cc). Generated by: perf --record FILE" << std::endl;
+    for (std::map<std::string, double>::iterator it=best.begin(); it!=best.end(); it++)
+      of << it->first << " " << it->second * PERF_MARGIN << std::endl;
+    return CPCD_SUCCESS;
+  }
+
+  // compare with baseline
+  const char* srcdir = std::getenv("srcdir");
+  std::string filename = std::string(srcdir ? srcdir : ".") + "/perf.baseline";
+  std::ifstream is(filename);
+  if (!is) {
+    std::cerr << "Error: unable to open file: " << filename << std::endl;
+    return CPCD_FAILURE;
+  }
+
+  int rc = CPCD_SUCCESS;
+  std::string line;
+  while (std::getline(is, line)) {
+    std::istringstream ls(line);
+    std::string phase;
+    double maximum;
+    if (line.empty() || line[0] == '#' || !(ls >> phase >> maximum))
+      continue;
+    if (best.find(phase) == best.end()) {
+      std::cerr << "Error: unknown phase in baseline: " << phase << std::endl;
+      rc = CPCD_FAILURE;
+      continue;
+    }
+    bool pass = (best[phase] <= maximum);
+    std::cout << phase << ": " << best[phase] << " (baseline " << maximum << ") "
+              << (pass ? "passed" : "FAILED") << std::endl;
+    if (!pass)
+      rc = CPCD_FAILURE;
+  }
+  return rc;
+}
@@ -0,0 +1,374 @@
+/*  Stress - Property-based stress test for the CPCD loader and resolver
+    Copyright (C) 2019  National Earth System Prediction Capability/CSC
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/*  Generates synthetic dictionaries and requests from a fixed seed and
+    checks that:
+    - every requested constant found in the dictionary is emitted
+      exactly once, and no other constant is emitted;
+    - lazy and full loading emit identical modules, also for set list
+      layouts that cannot be loaded on demand;
+    - a dictionary compared with itself has no changes, changing a
+      single value is reported as a single modified constant, changing
+      a set citation is reported for each constant of the set, and an
+      empty request is not affected by changes;
+    - literals are verified in their precision: inexact values are
+      reported as warnings, invalid and overflowing values as errors;
+    - randomly mutated inputs neither crash nor stall.
+    Run time of each input is recorded. The run fails if any input takes
+    longer than STRESS_MAX_TIME seconds, or if doubling the dictionary
+    size more than STRESS_MAX_RATIO times increases the run time.
+
+    Build from the top source directory, e.g.:
+
+      g++ -std=c++11 -O2 -I include -I test test/stress.cc src/cpcd.cc \
+        -lyaml-cpp -o cpcd-stress
+
+    Usage: cpcd-stress [SEED] */
+
+#include "cpcd.h"
+#include "synthetic.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <set>
+
+#define STRESS_TRIALS    100
+#define STRESS_MUTATIONS 1000
+#define STRESS_MAX_TIME  1.0
+#define STRESS_MAX_RATIO 3.0
+
+
+namespace {
+
+  using namespace Synthetic;
+
+  // resolved constant as (set, name, value)
+  typedef std::multiset<std::string> Constants;
+
+  int failures = 0;
+
+  void
+  Fail (const std::string& property, const std::string& details)
+  {
+    std::cout << "FAILED: " << property << ": " << details << std::endl;
+    failures++;
+  }
+
+  std::string
+  Key (const std::string& set, const std::string& name, const std::string& value)
+  {
+    return set + " " + name + " " + value;
+  }
+
+  std::string
+  Request (Random& rng, const Dictionary& dict, Constants& expected)
+  {
+    // write random request, including duplicate and unknown
+    // names, and return constants expected in output
+    std::ostringstream os;
+    std::set<std::string> found;
+    int nsets = 1 + rng() % 4;
+    for (int i=0; i<nsets; i++) {
+      bool unknown = (rng() % 8 == 0);
+      const Set& set = dict[rng() % dict.size()];
+      std::string name = unknown ? "UNKNOWN" + std::to_string(i) : set.name;
+      os << name << ": [ ";
+      int n = 1 + rng() % 5;
+      for (int k=0; k<n; k++) {
+        const Entry& entry = set.entries[rng() % set.entries.size()];
+        if (rng() % 8 == 0) {
+          os << "unknown_" << k << ", ";
+        } else {
+          os << entry.name << ", ";
+          if (!unknown)
+            found.insert(Key(name, entry.name, entry.value));
+        }
+      }
+      os << "]\n";
+    }
+    expected.insert(found.begin(), found.end());
+    return os.str();
+  }
+
+  Constants
+  Emitted (const std::string& module)
+  {
+    // retrieve (set, name, value) from emitted Fortran module
+    Constants constants;
+    std::istringstream is(module);
+    std::string line, set;
+    while (std::getline(is, line)) {
+      if (!line.compare(0, 13, "! - from set ")) {
+        set = line.substr(13);
+      } else if (!line.compare(0, 7, "  real(")) {
+        std::size_t b = line.find(":: ") + 3 + set.size() + 1;
+        std::size_t e = line.find(" = ");
+        std::size_t v = line.rfind("_cpcd_kind");
+        constants.insert(Key(set, line.substr(b, e - b), line.substr(e + 3, v - e - 3)));
+      }
+    }
+    return constants;
+  }
+
+  double
+  Run (const std::string& dictionary, const std::string& request, int lazy,
+       std::string& module, int& rc)
+  {
+    // load, resolve, and emit request, returning elapsed time
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::ostringstream os;
+    CPCD::CPCD doc;
+    doc.lazy = lazy;
+    rc = doc.load (dictionary);
+    if (rc == CPCD_SUCCESS)
+      rc = doc.loadreq (request);
+    if (rc == CPCD_SUCCESS)
+      rc = doc.parse ();
+    if (rc == CPCD_SUCCESS)
+      rc = doc.femit (os);
+    module = os.str();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+
+  void
+  CheckProperties (Random& rng)
+  {
+    for (int trial=0; trial<STRESS_TRIALS; trial++) {
+      Dictionary dict = Generate(rng, 1 + rng() % 10, 1 + rng() % 20);
+      int layout = trial % NLAYOUTS;
+      std::string text = Format(dict);
+      Constants expected;
+      std::string request = Request(rng, dict, expected);
+
+      // requested constants are emitted exactly once, unless
+      // a set list item holds an extra key
+      std::string full, lazy;
+      int rc, lrc;
+      std::string variant = Format(dict, layout);
+      Run(variant, request, 0, full, rc);
+      if (layout != EXTRA && (rc != CPCD_SUCCESS || Emitted(full) != expected))
+        Fail("resolution", "trial " + std::to_string(trial) + "\n" + variant + "\n%%\n" + request);
+
+      // lazy loading emits identical module, or fails likewise
+      Run(variant, request, 1, lazy, lrc);
+      if (lrc != rc || lazy != full)
+        Fail("lazy loading", "trial " + std::to_string(trial) + "\n" + variant + "\n%%\n" + request);
+
+      // unchanged dictionary has no changes
+      CPCD::CPCD doc, ref;
+      CPCD::Node changes;
+      doc.load (text);
+      ref.load (text);
+      if (doc.diff (ref, changes) != CPCD_SUCCESS || changes.size() != 0)
+        Fail("diff", "trial " + std::to_string(trial) + ": unchanged dictionary");
+
+      // single changed value is reported
+      Set& set = dict[rng() % dict.size()];
+      Entry& entry = set.entries[rng() % set.entries.size()];
+      entry.value += "1";
+      doc.load (Format(dict));
+      if (doc.diff (ref, changes) != CPCD_SUCCESS || changes.size() != 1 ||
+          changes[set.name].size() != 1 ||
+          changes[set.name][entry.name].as<std::string>() != "modified")
+        Fail("diff", "trial " + std::to_string(trial) + ": " + set.name + "/" + entry.name);
+
+      // changed set citation is reported for each constant of the set
+      ref.load (Format(dict));
+      set.citation = "Updated.";
+      doc.load (Format(dict));
+      if (doc.diff (ref, changes) != CPCD_SUCCESS || changes.size() != 1 ||
+          changes[set.name].size() != set.entries.size())
+        Fail("diff", "trial " + std::to_string(trial) + ": " + set.name + " citation");
+
+      // empty request is not affected by changes
+      if (doc.loadreq ("# no constants\n") != CPCD_SUCCESS ||
+          doc.diff (ref, changes) != CPCD_SUCCESS || changes.size() != 0)
+        Fail("diff", "trial " + std::to_string(trial) + ": empty request");
+    }
+    std::cout << "properties: " << STRESS_TRIALS << " trials" << std::endl;
+  }
+
+  void
+  CheckVerify ()
+  {
+    // check literal verification of single constants
+    // in double or single precision
+    struct Case {
+      const char* value;
+      const char* prec;
+      int         rc;       // expected return code
+      bool        warning;  // expected warning
+    };
+    static const Case cases[] = {
+      { "3.141592653589793238462643",         "double", CPCD_SUCCESS, true  },
+      { "0.10000000000000001",                "double", CPCD_SUCCESS, false },
+      { "1.5D+3",                             "double", CPCD_SUCCESS, false },
+      { "1.0000000000000000000000001e-310",   "double", CPCD_SUCCESS, true  },
+      { "1.0E+50",                            "single", CPCD_FAILURE, false },
+      { "10e9223372036854775807",             "double", CPCD_FAILURE, false },
+      { "1.0.0",                              "double", CPCD_FAILURE, false }
+    };
+    for (std::size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+      Dictionary dict(1);
+      dict[0].name = "SET0";
+      dict[0].citation = "None.";
+      dict[0].entries.resize(1);
+      dict[0].entries[0].name  = "constant_0";
+      dict[0].entries[0].value = cases[i].value;
+      dict[0].entries[0].prec  = cases[i].prec;
+
+      CPCD::CPCD doc;
+      std::ostringstream log;
+      std::streambuf* buf = std::cerr.rdbuf(log.rdbuf());
+      int rc = doc.load (Format(dict));
+      if (rc == CPCD_SUCCESS)
+        rc = doc.loadreq ("SET0: constant_0");
+      if (rc == CPCD_SUCCESS)
+        rc = doc.parse ();
+      if (rc == CPCD_SUCCESS)
+        rc = doc.verify ();
+      std::cerr.rdbuf(buf);
+
+      bool warning = (log.str().find("Warning:") != std::string::npos);
+      if (rc != cases[i].rc || warning != cases[i].warning)
+        Fail("verify", std::string(cases[i].value) + " in " + cases[i].prec +
+             " precision: " + log.str());
+    }
+    std::cout << "verify: " << sizeof(cases)/sizeof(cases[0]) << " literals" << std::endl;
+  }
+
+  std::string
+  Mutate (Random& rng, std::string text)
+  {
+    // apply random byte-level and structural mutations
+    static const std::string tokens[] = {
+      ":", "-", "- ", "[", "]", "{", "}", "&a ", "*a", "!!map ", "|", ">",
+      "'", "\"", "#", "\n", "    ", "~", ",", "? ", "---\n", "%YAML 1.2\n",
+      "set:", "entries:", "name:", "value:"
+    };
+    const std::size_t ntokens = sizeof(tokens) / sizeof(tokens[0]);
+    int n = 1 + rng() % 8;
+    for (int i=0; i<n && !text.empty(); i++) {
+      std::size_t pos = rng() % text.size();
+      std::size_t len = 1 + rng() % std::min<std::size_t>(64, text.size() - pos);
+      switch (rng() % 4) {
+        case 0:
+          text.erase(pos, len);
+          break;
+        case 1:
+          text.insert(pos, text.substr(pos, len));
+          break;
+        case 2:
+          text[pos] = static_cast<char>(rng() % 256);
+          break;
+        default:
+          text.insert(pos, tokens[rng() % ntokens]);
+          break;
+      }
+    }
+    return text;
+  }
+
+  void
+  CheckMutations (Random& rng)
+  {
+    double worst = 0.0;
+    std::size_t worstsize = 0;
+    for (int trial=0; trial<STRESS_MUTATIONS; trial++) {
+      Dictionary dict = Generate(rng, 1 + rng() % 8, 1 + rng() % 8);
+      Constants expected;
+      std::string text    = Mutate(rng, Format(dict));
+      std::string request = Mutate(rng, Request(rng, dict, expected));
+
+      // mutated inputs may fail, but must complete in bounded time
+      std::string module;
+      int rc;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      Run(text, request, trial % 2, module, rc);
+      CPCD::CPCD doc, ref;
+      CPCD::Node changes;
+      if (doc.load (text) == CPCD_SUCCESS) {
+        doc.validate ();
+        if (ref.load (Format(dict)) == CPCD_SUCCESS)
+          doc.diff (ref, changes);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      if (elapsed.count() > worst) {
+        worst     = elapsed.count();
+        worstsize = text.size() + request.size();
+      }
+      if (elapsed.count() > STRESS_MAX_TIME)
+        Fail("mutation", "trial " + std::to_string(trial) + " took " +
+             std::to_string(elapsed.count()) + " s\n" + text + "\n%%\n" + request);
+    }
+    std::cout << "mutations: " << STRESS_MUTATIONS << " inputs, slowest "
+              << worst * 1000.0 << " ms (" << worstsize << " bytes)" << std::endl;
+  }
+
+  void
+  CheckScaling (Random& rng)
+  {
+    // run time of large dictionaries should scale linearly
+    for (int lazy=0; lazy<2; lazy++) {
+      double previous = 0.0;
+      for (int nsets=125; nsets<=1000; nsets*=2) {
+        Dictionary dict = Generate(rng, nsets, 10);
+        std::string text = Format(dict);
+        Constants expected;
+        std::string request = Request(rng, dict, expected);
+        std::string module;
+        int rc;
+        double best = 0.0;
+        for (int rep=0; rep<3; rep++) {
+          double t = Run(text, request, lazy, module, rc);
+          best = (rep == 0) ? t : std::min(best, t);
+        }
+        std::cout << "scaling: " << (lazy ? "lazy" : "full") << " " << nsets
+                  << " sets, " << text.size() << " bytes, " << best * 1000.0
+                  << " ms" << std::endl;
+        if (previous > 0.0 && best > STRESS_MAX_RATIO * previous && best > 0.01)
+          Fail("scaling", std::to_string(nsets) + " sets: super-linear run time");
+        previous = best;
+      }
+    }
+  }
+
+} // namespace
+
+
+int
+main (int argc, char** argv)
+{
+  unsigned int seed = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 2019;
+  Random rng(seed);
+  std::cout << "seed: " << seed << std::endl;
+
+  // silence error messages from failing inputs
+  std::ostringstream log;
+  std::streambuf* buf = std::cerr.rdbuf(log.rdbuf());
+
+  CheckProperties(rng);
+  CheckVerify();
+  CheckMutations(rng);
+  CheckScaling(rng);
+
+  std::cerr.rdbuf(buf);
+
+  return failures ? CPCD_FAILURE : CPCD_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/*  Synthetic - Synthetic dictionaries for CPCD tests
+    Copyright (C) 2019  National Earth System Prediction Capability/CSC
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/*  Generates synthetic dictionaries with random values from a given
+    random number generator, and writes them in the layout of pcd.yaml
+    or in one of its variants. Shared by the stress and perf tests. */
+
+#ifndef _SYNTHETIC_H_
+#define _SYNTHETIC_H_
+
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Synthetic {
+
+  typedef std::mt19937 Random;
+
+  // synthetic dictionary
+  struct Entry {
+    std::string name;
+    std::string value;
+    std::string prec;
+  };
+  struct Set {
+    std::string        name;
+    std::string        citation;
+    std::vector<Entry> entries;
+  };
+  typedef std::vector<Set> Dictionary;
+
+  inline std::string
+  Number (Random& rng)
+  {
+    // random numeric literal in one of the dictionary formats
+    std::ostringstream os;
+    std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    os.precision(std::uniform_int_distribution<int>(1, 25)(rng));
+    switch (rng() % 3) {
+      case 0:
+        os << std::uniform_int_distribution<int>(0, 999999999)(rng);
+        break;
+      case 1: {
+        int exp = exponent(rng);
+        os << mantissa(rng) << "E" << (exp < 0 ? "-" : "+") << std::abs(exp);
+        break;
+      }
+      default:
+        os << std::fixed << mantissa(rng);
+        break;
+    }
+    return os.str();
+  }
+
+  inline Dictionary
+  Generate (Random& rng, int nsets, int nentries)
+  {
+    Dictionary dict(nsets);
+    for (int s=0; s<nsets; s++) {
+      dict[s].name = "SET" + std::to_string(s);
+      dict[s].citation = "None.";
+      dict[s].entries.resize(nentries);
+      for (int e=0; e<nentries; e++) {
+        dict[s].entries[e].name  = "constant_" + std::to_string(e);
+        dict[s].entries[e].value = Number(rng);
+        dict[s].entries[e].prec  = "double";
+      }
+    }
+    return dict;
+  }
+
+  enum Layout {
+    CANONICAL,  // layout of pcd.yaml
+    FLOW,       // set as flow mapping: - { NAME: { ... } }
+    BLANK,      // blank before key separator: - NAME :
+    ANCHOR,     // anchored set name: - &sN NAME:
+    EXTRA,      // additional key in set list item
+    QUOTED,     // quoted scalar holding set list item line: "\n- FAKE: ..."
+    NLAYOUTS
+  };
+
+  inline std::string
+  Format (const Dictionary& dict, int layout = CANONICAL)
+  {
+    // write dictionary in the layout of pcd.yaml, or in one
+    // of its variants for the first set
+    std::ostringstream os;
+    os << "physical_constants_dictionary:\n"
+       << "  version_number: 0.0.0\n"
+       << "  institution: stress\n"
+       << "  description: synthetic dictionary\n"
+       << "  contact: none\n"
+       << "  set:\n";
+    for (Dictionary::const_iterator is=dict.begin(); is!=dict.end(); is++) {
+      if (is == dict.begin() && layout == FLOW) {
+        os << "    - { " << is->name << ": { description: Synthetic set., "
+           << "citation: " << is->citation << ", entries: [";
+        for (std::vector<Entry>::const_iterator ie=is->entries.begin(); ie!=is->entries.end(); ie++) {
+          os << (ie == is->entries.begin() ? " " : ", ")
+             << "{ name: " << ie->name << ", value: " << ie->value << ", units: none, "
+             << "prec: " << ie->prec << ", type: strict, uncertainty: exact, description: Synthetic constant. }";
+        }
+        os << " ] } }\n";
+        continue;
+      }
+      if (is == dict.begin() && layout == BLANK)
+        os << "    - " << is->name << " :\n";
+      else if (is == dict.begin() && layout == ANCHOR)
+        os << "    - &s0 " << is->name << ":\n";
+      else
+        os << "    - " << is->name << ":\n";
+      if (is == dict.begin() && layout == EXTRA)
+        os << "      EXTRA" << is->name << ":\n";
+      if (is == dict.begin() && layout == QUOTED)
+        os << "        description: \"\n    - FAKE" << is->name << ": Synthetic set.\n        \"\n";
+      else
+        os << "        description: \"\n          Synthetic set.\n        \"\n";
+      os << "        citation: \"\n          " << is->citation << "\n        \"\n"
+         << "        entries:\n";
+      for (std::vector<Entry>::const_iterator ie=is->entries.begin(); ie!=is->entries.end(); ie++) {
+        os << "          - name: " << ie->name << "\n"
+           << "            value: " << ie->value << "\n"
+           << "            units: none\n"
+           << "            prec: " << ie->prec << "\n"
+           << "            type: strict\n"
+           << "            uncertainty: exact\n"
+           << "            description: \"\n              Synthetic constant.\n            \"\n";
+      }
+    }
+    return os.str();
+  }
+
+} // namespace Synthetic
+
+#endif // _SYNTHETIC_H_